@@ -1,91 +1,66 @@
 #include <iostream>
 #include <vector>
 #include <chrono>
-#include <pthread.h>
+#include "matrix.h"
+#include "attention_kernel.h"
+#include "thread_pool.h"
+#include "tensor_io.h"
+#include "output_writer.h"
 using namespace std;
 
 // 전역 변수: 행렬 크기 및 결과 저장
 int Rq, C, Rk, D;
-vector<vector<int>> Q, K, V, result;
+Matrix<int> Q, K, V, result;
 
-// 스레드별로 연산할 row 구간 정의
-struct ThreadArg {
-    int start_row, end_row;
-};
-
-// 각 스레드에서 실행될 함수 - attention 연산
-void* compute_attention(void* arg) {
-    ThreadArg* t = (ThreadArg*)arg;
-    for (int i = t->start_row; i < t->end_row; ++i) {
-        for (int j = 0; j < Rk; ++j) {
-            int dot = 0;
-            for (int k = 0; k < C; ++k) {
-                dot += Q[i][k] * K[j][k];  // Q * Kᵀ 연산
-            }
-            for (int d = 0; d < D; ++d) {
-                result[i][d] += dot * V[j][d];  // 곱한 결과에 V까지 곱해주기
-            }
-        }
-    }
-    return nullptr;
-}
+// 시작 시 CPUID로 선택된 dot/axpy 커널
+const Kernels* kernels = nullptr;
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        cerr << "Usage: ./attention [total_thread_num]" << endl;
+    const char* kernel_name = kernel_option(argc, argv);
+    OutputFormat out_fmt;
+    int total_thread_num;
+    if (positional_count(argc, argv) != 1 || !parse_int(positional_arg(argc, argv), total_thread_num) ||
+        total_thread_num < 1 || !parse_output_format(find_option(argc, argv, "--output="), out_fmt)) {
+        cerr << "Usage: ./attention [total_thread_num] [--kernel=avx512|avx2|sse41|scalar] "
+                "[--output=text|binary]" << endl;
         return 1;
     }
 
-    int total_thread_num = atoi(argv[1]);
-
-    // Q 입력
-    cin >> Rq >> C;
-    Q.assign(Rq, vector<int>(C));
-    for (auto& row : Q) for (int& x : row) cin >> x;
+    kernels = select_kernels(kernel_name);
+    if (!kernels) {
+        cerr << "Unsupported kernel: " << kernel_name << endl;
+        return 1;
+    }
 
-    // K 입력
-    cin >> Rk >> C;
-    K.assign(Rk, vector<int>(C));
-    for (auto& row : K) for (int& x : row) cin >> x;
+    // 입력: 텍스트 또는 바이너리 텐서 파일 (일반 파일이면 mmap 후 복사 없이 사용)
+    InputBuffer input;
+    vector<HeadInput> heads;
+    if (!input.load(STDIN_FILENO) || !load_heads(input, false, heads) || heads.size() != 1) {
+        cerr << "Invalid input" << endl;
+        return 1;
+    }
+    Q = std::move(heads[0].Q);
+    K = std::move(heads[0].K);
+    V = std::move(heads[0].V);
+    Rq = Q.rows(); C = Q.cols(); Rk = K.rows(); D = V.cols();
 
-    // V 입력
-    cin >> Rk >> D;
-    V.assign(Rk, vector<int>(D));
-    for (auto& row : V) for (int& x : row) cin >> x;
+    result.assign(Rq, D);  // 결과 행렬 초기화 (0으로 채워짐)
 
-    result.assign(Rq, vector<int>(D, 0));  // 결과 행렬 초기화
+    // 워커 스레드는 시간 측정 전에 미리 생성해 둔다
+    ThreadPool pool(total_thread_num);
 
     auto start = chrono::high_resolution_clock::now();  // 시간 측정 시작
 
-    // 스레드 생성 및 분할
-    vector<pthread_t> threads(total_thread_num);
-    vector<ThreadArg> args(total_thread_num);
-
-    int rows_per_thread = Rq / total_thread_num;
-    int remainder = Rq % total_thread_num;
-
-    int curr = 0;
-    for (int i = 0; i < total_thread_num; ++i) {
-        args[i].start_row = curr;
-        args[i].end_row = curr + rows_per_thread + (i < remainder ? 1 : 0);
-        curr = args[i].end_row;
-        pthread_create(&threads[i], nullptr, compute_attention, &args[i]);
-    }
-
-    // 모든 스레드 종료 대기
-    for (int i = 0; i < total_thread_num; ++i) {
-        pthread_join(threads[i], nullptr);
-    }
+    // Q 행 블록 단위 작업을 워커 deque에 나눠 주고, 먼저 끝난 워커는 나머지를 훔쳐 간다
+    pool.parallel_for(attention_tasks(Rq), [&](int task) {
+        attention_task(Q, K, V, result, task, *kernels);
+    });
 
     auto end = chrono::high_resolution_clock::now();
     int latency = chrono::duration_cast<chrono::milliseconds>(end - start).count();
 
-    // 출력 형식: 시간 + 결과 행렬
-    cout << latency << endl;
-    for (auto& row : result) {
-        for (int x : row) cout << x << ' ';
-        cout << '\n';
-    }
+    // 출력 형식: 시간 + 결과 행렬 (버퍼링 후 write(2), 또는 바이너리 텐서)
+    write_result(STDOUT_FILENO, out_fmt, latency, result);
 
     return 0;
 }
@@ -0,0 +1,61 @@
+#ifndef ATTENTION_KERNEL_H
+#define ATTENTION_KERNEL_H
+
+#include <algorithm>
+#include <vector>
+#include "matrix.h"
+#include "simd_kernels.h"
+
+// 타일 크기 설정: Q 타일의 결과 행은 L1에, K/V 타일은 L2에 머물도록 잡는다.
+const int TILE_Q = 16;                 // 한 번에 처리할 Q 행 수
+const int L2_TILE_BYTES = 256 * 1024;  // K/V 타일이 차지할 최대 바이트 수
+
+// K/V 타일의 행 수: (C + D)개 int로 이루어진 K/V 행이 L2 예산에 들어가도록 계산
+inline int kv_tile_rows(int C, int D, int Rk) {
+    int row_bytes = (C + D) * (int)sizeof(int);
+    int rows = row_bytes > 0 ? L2_TILE_BYTES / row_bytes : Rk;
+    return std::max(8, std::min(rows, 256));
+}
+
+// Q의 [row_begin, row_end) 행에 대한 attention 결과를 result에 누적한다.
+// Q 행 블록 × K/V 행 블록 단위로 계산해 K/V 타일을 여러 Q 행이 재사용한다.
+// 정수 덧셈 순서만 바뀌므로 결과는 단순 3중 루프와 비트 단위로 동일하다.
+inline void attention_rows(const Matrix<int>& Q, const Matrix<int>& K, const Matrix<int>& V,
+                           Matrix<int>& result, int row_begin, int row_end, const Kernels& kern) {
+    int C = Q.cols(), D = V.cols(), Rk = K.rows();
+    int tile_k = kv_tile_rows(C, D, Rk);
+    static thread_local std::vector<int> score;  // Q 타일 · K 타일ᵀ 결과 (스레드별 재사용)
+    score.resize(TILE_Q * tile_k);
+
+    for (int i0 = row_begin; i0 < row_end; i0 += TILE_Q) {
+        int i1 = std::min(i0 + TILE_Q, row_end);
+        for (int j0 = 0; j0 < Rk; j0 += tile_k) {
+            int j1 = std::min(j0 + tile_k, Rk);
+
+            // 1) Q 타일 * K 타일ᵀ
+            for (int i = i0; i < i1; ++i) {
+                int* s = &score[(i - i0) * tile_k];
+                for (int j = j0; j < j1; ++j) s[j - j0] = kern.dot(Q[i], K[j], C);
+            }
+
+            // 2) 점수 타일 * V 타일을 결과 행에 누적
+            for (int i = i0; i < i1; ++i) {
+                const int* s = &score[(i - i0) * tile_k];
+                for (int j = j0; j < j1; ++j) kern.axpy(result[i], s[j - j0], V[j], D);
+            }
+        }
+    }
+}
+
+// Q 행 블록(TILE_Q 행) 단위 작업 수: 스레드 풀의 스케줄링 단위
+inline int attention_tasks(int Rq) { return (Rq + TILE_Q - 1) / TILE_Q; }
+
+// 작업 번호 task에 해당하는 Q 행 블록 하나를 계산
+inline void attention_task(const Matrix<int>& Q, const Matrix<int>& K, const Matrix<int>& V,
+                           Matrix<int>& result, int task, const Kernels& kern) {
+    int row_begin = task * TILE_Q;
+    int row_end = std::min(row_begin + TILE_Q, Q.rows());
+    attention_rows(Q, K, V, result, row_begin, row_end, kern);
+}
+
+#endif
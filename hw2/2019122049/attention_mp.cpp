@@ -2,95 +2,89 @@
 #include <vector>
 #include <chrono>
 #include <cstdlib>
-#include <pthread.h>
+#include <sys/mman.h>
+#include "matrix.h"
+#include "attention_kernel.h"
+#include "thread_pool.h"
+#include "tensor_io.h"
+#include "output_writer.h"
 using namespace std;
 
 int Rq, C, Rk, D;
-vector<vector<int>> Q, K, V, result;
+Matrix<int> Q, K, V, result;
 
-struct ThreadArg {
-    int start_row, end_row;
-};
-
-void* compute_attention(void* arg) {
-    ThreadArg* t = (ThreadArg*)arg;
-    for (int i = t->start_row; i < t->end_row; ++i) {
-        for (int j = 0; j < Rk; ++j) {
-            int dot = 0;
-            for (int k = 0; k < C; ++k) dot += Q[i][k] * K[j][k];
-            for (int d = 0; d < D; ++d) result[i][d] += dot * V[j][d];
-        }
-    }
-    return nullptr;
-}
+const Kernels* kernels = nullptr;
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        cerr << "Usage: ./attention_mp [head_index]" << endl;
+    const char* kernel_name = kernel_option(argc, argv);
+    const char* threads_opt = find_option(argc, argv, "--threads=");
+    const char* out_fd_opt = find_option(argc, argv, "--out-fd=");
+    OutputFormat out_fmt;
+    int head_idx, threads = 0, out_fd = -1;  // threads 0: 하드웨어 동시 실행 수
+    if (positional_count(argc, argv) != 1 || !parse_int(positional_arg(argc, argv), head_idx) || head_idx < 0 ||
+        (threads_opt && (!parse_int(threads_opt, threads) || threads < 1)) ||
+        (out_fd_opt && (!parse_int(out_fd_opt, out_fd) || out_fd < 0)) ||
+        !parse_output_format(find_option(argc, argv, "--output="), out_fmt)) {
+        cerr << "Usage: ./attention_mp [head_index] [--threads=N] [--out-fd=FD] "
+                "[--kernel=avx512|avx2|sse41|scalar] [--output=text|binary]" << endl;
         return 1;
     }
 
-    int head_idx = atoi(argv[1]);
+    kernels = select_kernels(kernel_name);
+    if (!kernels) {
+        cerr << "Unsupported kernel: " << kernel_name << endl;
+        return 1;
+    }
 
-    int H;
-    cin >> H;
+    // 입력 전체를 한 번에 읽는다 (텍스트 또는 바이너리 텐서 파일)
+    InputBuffer input;
+    vector<HeadInput> heads;
+    if (!input.load(STDIN_FILENO) || !load_heads(input, true, heads)) {
+        cerr << "Invalid input" << endl;
+        return 1;
+    }
+    int H = heads.size();
     if (head_idx < 0 || head_idx >= H) {
         cerr << "Invalid head index" << endl;
         return 1;
     }
 
-    // 모든 head를 순회하되, 지정된 head만 저장
-    for (int h = 0; h < H; ++h) {
-        int r, c, d;
-        vector<vector<int>> tmpQ, tmpK, tmpV;
-
-        cin >> r >> c;
-        tmpQ.assign(r, vector<int>(c));
-        for (auto& row : tmpQ) for (int& x : row) cin >> x;
-
-        cin >> r >> c;
-        tmpK.assign(r, vector<int>(c));
-        for (auto& row : tmpK) for (int& x : row) cin >> x;
-
-        cin >> r >> d;
-        tmpV.assign(r, vector<int>(d));
-        for (auto& row : tmpV) for (int& x : row) cin >> x;
-
-        // 해당 head의 행렬만 사용
-        if (h == head_idx) {
-            Q = tmpQ; K = tmpK; V = tmpV;
-            Rq = Q.size(); Rk = K.size(); C = Q[0].size(); D = V[0].size();
+    // 지정된 head의 행렬만 사용 (버퍼 소유권만 넘김)
+    Q = std::move(heads[head_idx].Q);
+    K = std::move(heads[head_idx].K);
+    V = std::move(heads[head_idx].V);
+    Rq = Q.rows(); Rk = K.rows(); C = Q.cols(); D = V.cols();
+
+    // --out-fd: 부모가 만든 공유 결과 영역(H x Rq x D)의 자기 head 구간에 바로 누적
+    if (out_fd >= 0) {
+        size_t bytes = (size_t)H * Rq * D * sizeof(int);
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, out_fd, 0);
+        if (p == MAP_FAILED) {
+            perror("mmap");
+            return 1;
         }
+        result = Matrix<int>::borrow((int*)p + (size_t)head_idx * Rq * D, Rq, D, D);
+    } else {
+        result.assign(Rq, D);
     }
 
-    result.assign(Rq, vector<int>(D, 0));
+    // 기본 스레드 수는 하드웨어 동시 실행 수 (--threads=N으로 변경)
+    ThreadPool pool(threads);
 
     auto start = chrono::high_resolution_clock::now();
 
-    int thread_num = 4;  // 고정 스레드 수
-    vector<pthread_t> threads(thread_num);
-    vector<ThreadArg> args(thread_num);
-
-    int rows_per_thread = Rq / thread_num;
-    int rem = Rq % thread_num, curr = 0;
-
-    for (int i = 0; i < thread_num; ++i) {
-        args[i].start_row = curr;
-        args[i].end_row = curr + rows_per_thread + (i < rem ? 1 : 0);
-        curr = args[i].end_row;
-        pthread_create(&threads[i], nullptr, compute_attention, &args[i]);
-    }
-    for (auto& t : threads) pthread_join(t, nullptr);
+    pool.parallel_for(attention_tasks(Rq), [&](int task) {
+        attention_task(Q, K, V, result, task, *kernels);
+    });
 
     auto end = chrono::high_resolution_clock::now();
     int latency = chrono::duration_cast<chrono::milliseconds>(end - start).count();
 
+    // 공유 영역에 썼다면 텍스트 출력은 생략
+    if (out_fd_opt) return 0;
+
     // 출력: latency + attention 결과
-    cout << latency << endl;
-    for (auto& row : result) {
-        for (int x : row) cout << x << ' ';
-        cout << '\n';
-    }
+    write_result(STDOUT_FILENO, out_fmt, latency, result);
 
     return 0;
 }
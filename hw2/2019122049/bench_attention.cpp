@@ -0,0 +1,180 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "matrix.h"
+#include "attention_kernel.h"
+#include "thread_pool.h"
+#include "options.h"
+using namespace std;
+
+// attention 커널 벤치마크: 입력을 프로세스 안에서 만들고, 워밍업 후 반복 측정한다.
+// (kernel, threads, size) 조합마다 나노초 단위 median/p95/stddev, GFLOP/s, 이동 바이트를 출력한다.
+// CSV의 Threads / "Size (R=C)" / "Latency (ms)" 열은 benchmark_attention.py의 그래프 함수와 같은 이름이다.
+
+struct BenchResult {
+    string kernel;
+    int threads, R, C, D;
+    int trials;
+    double median_ns, p95_ns, mean_ns, stddev_ns;
+    double gflops;
+    double bytes;
+};
+
+// "1,2,4" 형태의 목록 해석
+vector<int> parse_int_list(const char* s) {
+    vector<int> out;
+    while (s && *s) {
+        out.push_back(atoi(s));
+        const char* comma = strchr(s, ',');
+        s = comma ? comma + 1 : nullptr;
+    }
+    return out;
+}
+
+vector<string> parse_str_list(const char* s) {
+    vector<string> out;
+    while (s && *s) {
+        const char* comma = strchr(s, ',');
+        out.push_back(comma ? string(s, comma) : string(s));
+        s = comma ? comma + 1 : nullptr;
+    }
+    return out;
+}
+
+// benchmark_attention.py와 같은 분포(0~9 정수)로 행렬 채우기
+void fill_random(Matrix<int>& m, mt19937& rng) {
+    uniform_int_distribution<int> dist(0, 9);
+    for (int i = 0; i < m.rows(); ++i)
+        for (int j = 0; j < m.cols(); ++j) m[i][j] = dist(rng);
+}
+
+double percentile(const vector<double>& sorted, double p) {
+    size_t idx = (size_t)ceil(p * sorted.size());
+    return sorted[idx == 0 ? 0 : idx - 1];
+}
+
+BenchResult run_case(const Kernels& kern, ThreadPool& pool, const Matrix<int>& Q, const Matrix<int>& K,
+                     const Matrix<int>& V, Matrix<int>& result, int warmup, int trials) {
+    int Rq = Q.rows(), Rk = K.rows(), C = Q.cols(), D = V.cols();
+    vector<double> samples;
+    for (int t = 0; t < warmup + trials; ++t) {
+        for (int i = 0; i < Rq; ++i) memset(result[i], 0, D * sizeof(int));
+        auto start = chrono::steady_clock::now();
+        pool.parallel_for(attention_tasks(Rq), [&](int task) {
+            attention_task(Q, K, V, result, task, kern);
+        });
+        auto end = chrono::steady_clock::now();
+        if (t >= warmup) samples.push_back((double)chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+    }
+
+    BenchResult r;
+    r.kernel = kern.name;
+    r.threads = pool.size();
+    r.R = Rq; r.C = C; r.D = D;
+    r.trials = trials;
+    sort(samples.begin(), samples.end());
+    r.median_ns = samples.size() % 2 ? samples[samples.size() / 2]
+                                     : (samples[samples.size() / 2 - 1] + samples[samples.size() / 2]) / 2;
+    r.p95_ns = percentile(samples, 0.95);
+    double sum = 0, sq = 0;
+    for (double s : samples) sum += s;
+    r.mean_ns = sum / samples.size();
+    for (double s : samples) sq += (s - r.mean_ns) * (s - r.mean_ns);
+    r.stddev_ns = samples.size() > 1 ? sqrt(sq / (samples.size() - 1)) : 0.0;
+
+    // 곱셈+덧셈 2 flop: Q·Kᵀ (Rq*Rk*C) 와 점수·V (Rq*Rk*D)
+    double flops = 2.0 * Rq * Rk * (double)(C + D);
+    r.gflops = flops / r.median_ns;
+    // 최소 메모리 이동량: Q, K, V 읽기 + result 읽기/쓰기
+    r.bytes = sizeof(int) * ((double)Rq * C + (double)Rk * C + (double)Rk * D + 2.0 * Rq * D);
+    return r;
+}
+
+void print_csv(const vector<BenchResult>& rs) {
+    cout << "Kernel,Threads,Size (R=C),C,D,Trials,median_ns,p95_ns,mean_ns,stddev_ns,Latency (ms),GFLOP/s,Bytes,GB/s\n";
+    for (const BenchResult& r : rs) {
+        cout << r.kernel << ',' << r.threads << ',' << r.R << ',' << r.C << ',' << r.D << ','
+             << r.trials << ',' << (long long)r.median_ns << ',' << (long long)r.p95_ns << ','
+             << (long long)r.mean_ns << ',' << (long long)r.stddev_ns << ',' << r.median_ns / 1e6 << ','
+             << r.gflops << ',' << (long long)r.bytes << ',' << r.bytes / r.median_ns << '\n';
+    }
+}
+
+void print_json(const vector<BenchResult>& rs) {
+    cout << "[\n";
+    for (size_t i = 0; i < rs.size(); ++i) {
+        const BenchResult& r = rs[i];
+        cout << "  {\"kernel\": \"" << r.kernel << "\", \"threads\": " << r.threads << ", \"R\": " << r.R
+             << ", \"C\": " << r.C << ", \"D\": " << r.D << ", \"trials\": " << r.trials
+             << ", \"median_ns\": " << (long long)r.median_ns << ", \"p95_ns\": " << (long long)r.p95_ns
+             << ", \"mean_ns\": " << (long long)r.mean_ns << ", \"stddev_ns\": " << (long long)r.stddev_ns
+             << ", \"latency_ms\": " << r.median_ns / 1e6 << ", \"gflops\": " << r.gflops
+             << ", \"bytes\": " << (long long)r.bytes << ", \"gbps\": " << r.bytes / r.median_ns << "}"
+             << (i + 1 < rs.size() ? "," : "") << "\n";
+    }
+    cout << "]\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (positional_count(argc, argv) != 0) {
+        cerr << "Usage: ./bench_attention [--sizes=100,200,...] [--threads=1,2,...] [--kernels=avx2,scalar,...]\n"
+                "                         [--trials=N] [--warmup=N] [--format=csv|json] [--seed=N]" << endl;
+        return 1;
+    }
+
+    // 기본값: benchmark_attention.py의 size 실험 (R=C, D=R/2), 1 ~ 하드웨어 스레드 수
+    vector<int> sizes = parse_int_list(find_option(argc, argv, "--sizes="));
+    if (sizes.empty()) sizes = {100, 200, 400, 800};
+    vector<int> threads = parse_int_list(find_option(argc, argv, "--threads="));
+    if (threads.empty())
+        for (int t = 1; t <= ThreadPool::default_threads(); t *= 2) threads.push_back(t);
+    vector<string> kernel_names = parse_str_list(find_option(argc, argv, "--kernels="));
+    vector<const Kernels*> kernels;
+    if (kernel_names.empty()) {
+        for (int i = 0; i < KERNEL_COUNT; ++i)
+            if (kernel_supported(KERNEL_TABLE[i])) kernels.push_back(&KERNEL_TABLE[i]);
+    } else {
+        for (const string& name : kernel_names) {
+            const Kernels* k = select_kernels(name.c_str());
+            if (!k) {
+                cerr << "Unsupported kernel: " << name << endl;
+                return 1;
+            }
+            kernels.push_back(k);
+        }
+    }
+    const char* trials_opt = find_option(argc, argv, "--trials=");
+    const char* warmup_opt = find_option(argc, argv, "--warmup=");
+    const char* format_opt = find_option(argc, argv, "--format=");
+    const char* seed_opt = find_option(argc, argv, "--seed=");
+    int trials = trials_opt ? max(1, atoi(trials_opt)) : 11;
+    int warmup = warmup_opt ? max(0, atoi(warmup_opt)) : 2;
+    bool json = format_opt && strcmp(format_opt, "json") == 0;
+    mt19937 rng(seed_opt ? atoi(seed_opt) : 2019122049);
+
+    vector<BenchResult> results;
+    for (int size : sizes) {
+        int R = size, C = size, D = max(1, size / 2);
+        Matrix<int> Q(R, C), K(R, C), V(R, D), result(R, D);
+        fill_random(Q, rng); fill_random(K, rng); fill_random(V, rng);
+
+        for (int t : threads) {
+            ThreadPool pool(t);
+            for (const Kernels* k : kernels) {
+                results.push_back(run_case(*k, pool, Q, K, V, result, warmup, trials));
+                cerr << k->name << " threads=" << t << " size=" << size << " median="
+                     << results.back().median_ns / 1e6 << "ms" << endl;
+            }
+        }
+    }
+
+    if (json) print_json(results);
+    else print_csv(results);
+    return 0;
+}
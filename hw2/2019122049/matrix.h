@@ -0,0 +1,104 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// 행렬 뷰: 버퍼를 소유하지 않고 연속 버퍼의 일부 블록을 가리킨다.
+template <typename T>
+struct MatrixView {
+    T* ptr;
+    int rows, cols;
+    size_t stride;  // 한 행에서 다음 행까지의 원소 수
+
+    T* operator[](int i) const { return ptr + (size_t)i * stride; }
+
+    // (r0, c0)에서 시작하는 nr x nc 하위 블록
+    MatrixView<T> block(int r0, int c0, int nr, int nc) const {
+        MatrixView<T> v = {ptr + (size_t)r0 * stride + c0, nr, nc, stride};
+        return v;
+    }
+};
+
+// 행 우선(row-major) 행렬: 하나의 정렬된 버퍼에 모든 행을 저장한다.
+// 각 행의 시작 주소가 ALIGN 바이트 경계에 오도록 stride를 올림한다.
+template <typename T>
+class Matrix {
+public:
+    static const size_t ALIGN = 64;  // 캐시 라인 / AVX-512 레지스터 크기
+
+    // cols개 원소를 담는 행의 stride (ALIGN 바이트 단위로 올림)
+    static size_t stride_for(int cols) {
+        size_t per_line = ALIGN / sizeof(T);
+        return ((size_t)cols + per_line - 1) / per_line * per_line;
+    }
+
+    Matrix() : buf(nullptr), n_rows(0), n_cols(0), row_stride(0), owned(true) {}
+    Matrix(int r, int c) : buf(nullptr), n_rows(0), n_cols(0), row_stride(0), owned(true) { assign(r, c); }
+    ~Matrix() { release(); }
+
+    // 외부 버퍼(예: mmap된 텐서 파일)를 복사 없이 감싼다. 버퍼 수명은 호출자가 관리한다.
+    static Matrix borrow(T* p, int r, int c, size_t stride) {
+        Matrix m;
+        m.buf = p; m.n_rows = r; m.n_cols = c; m.row_stride = stride;
+        m.owned = false;
+        return m;
+    }
+
+    Matrix(const Matrix&) = delete;
+    Matrix& operator=(const Matrix&) = delete;
+
+    Matrix(Matrix&& o)
+        : buf(o.buf), n_rows(o.n_rows), n_cols(o.n_cols), row_stride(o.row_stride), owned(o.owned) {
+        o.buf = nullptr; o.n_rows = o.n_cols = 0; o.row_stride = 0; o.owned = true;
+    }
+    Matrix& operator=(Matrix&& o) {
+        if (this != &o) {
+            release();
+            buf = o.buf; n_rows = o.n_rows; n_cols = o.n_cols; row_stride = o.row_stride; owned = o.owned;
+            o.buf = nullptr; o.n_rows = o.n_cols = 0; o.row_stride = 0; o.owned = true;
+        }
+        return *this;
+    }
+
+    // r x c 크기로 (재)할당하고 0으로 초기화한다. 할당은 한 번만 일어난다.
+    void assign(int r, int c) {
+        release();
+        n_rows = r; n_cols = c;
+        row_stride = stride_for(c);
+        size_t bytes = (size_t)r * row_stride * sizeof(T);
+        if (bytes == 0) return;
+        void* p = nullptr;
+        if (posix_memalign(&p, ALIGN, bytes) != 0) throw std::bad_alloc();
+        std::memset(p, 0, bytes);
+        buf = static_cast<T*>(p);
+    }
+
+    T* operator[](int i) { return buf + (size_t)i * row_stride; }
+    const T* operator[](int i) const { return buf + (size_t)i * row_stride; }
+
+    int rows() const { return n_rows; }
+    int cols() const { return n_cols; }
+    size_t stride() const { return row_stride; }
+    T* data() { return buf; }
+    const T* data() const { return buf; }
+
+    MatrixView<T> view() { MatrixView<T> v = {buf, n_rows, n_cols, row_stride}; return v; }
+    MatrixView<T> view(int r0, int c0, int nr, int nc) { return view().block(r0, c0, nr, nc); }
+    bool owns_buffer() const { return owned; }
+
+private:
+    T* buf;
+    int n_rows, n_cols;
+    size_t row_stride;
+    bool owned;  // false이면 borrow()로 감싼 외부 버퍼
+
+    void release() {
+        if (owned) std::free(buf);
+        buf = nullptr;
+        owned = true;
+    }
+};
+
+#endif
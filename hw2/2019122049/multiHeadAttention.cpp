@@ -1,69 +1,179 @@
 #include <iostream>
 #include <vector>
 #include <string>
-#include <sstream>
 #include <unistd.h>
 #include <sys/wait.h>
 #include <sys/mman.h>
 #include <fcntl.h>
 #include <cstring>
+#include <cerrno>
 #include <chrono>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include "matrix.h"
+#include "tensor_io.h"
+#include "options.h"
+#include "attention_kernel.h"
+#include "thread_pool.h"
+#include "output_writer.h"
 
 using namespace std;
 
 int Rq, Rk, C, D;
 
-// 공유 메모리로부터 결과를 누적
-void add_to_result(int* shm_ptr, vector<vector<int>>& result) {
-    for (int i = 0; i < Rq; ++i)
-        for (int j = 0; j < D; ++j)
-            result[i][j] += shm_ptr[i * D + j];
+// 공유 메모리의 head 결과 하나(Rq x D, 연속)를 누적. 행 블록 단위로 나눠 병렬로 더한다.
+void add_to_result(const int* shm_ptr, Matrix<int>& result, ThreadPool& pool, const Kernels& kern) {
+    pool.parallel_for(attention_tasks(Rq), [&](int tile) {
+        int r0 = tile * TILE_Q, r1 = min(r0 + TILE_Q, Rq);
+        for (int i = r0; i < r1; ++i) kern.axpy(result[i], 1, shm_ptr + (size_t)i * D, D);
+    });
 }
 
-int main() {
-    int H;
-    cin >> H;
+// --inproc 엔진: (head, Q 행 블록) 쌍을 하나의 작업으로 보고 한 스레드 풀에서 스케줄링한다.
+// 행 블록마다 남은 head 수를 원자적으로 세어, 마지막으로 끝낸 워커가 그 블록의
+// head 결과들을 바로 합산한다. 합산이 아직 계산 중인 다른 블록과 겹치고 잠금도 없다.
+void run_inproc(vector<HeadInput>& heads, Matrix<int>& result, ThreadPool& pool, const Kernels& kern) {
+    int H = heads.size();
+    int tiles = attention_tasks(Rq);
+    vector<Matrix<int>> head_out(H);
+    for (int h = 0; h < H; ++h) head_out[h].assign(Rq, D);
+    unique_ptr<atomic<int>[]> pending(new atomic<int>[tiles]);
+    for (int t = 0; t < tiles; ++t) pending[t].store(H, memory_order_relaxed);
 
-    stringstream full_input;
-    full_input << H << "\n";  // head 수 포함 전체 입력을 저장
+    // head x 행 블록 작업 (연속 번호라 한 워커가 같은 head의 K/V를 이어서 재사용)
+    pool.parallel_for(H * tiles, [&](int task) {
+        int h = task / tiles, tile = task % tiles;
+        attention_task(heads[h].Q, heads[h].K, heads[h].V, head_out[h], tile, kern);
 
-    // 모든 head 입력 읽기 & 버퍼 저장
-    for (int h = 0; h < H; ++h) {
-        cin >> Rq >> C;
-        full_input << Rq << " " << C << "\n";
-        for (int i = 0, x; i < Rq * C; ++i) {
-            cin >> x; full_input << x << " ";
-        }
-        full_input << "\n";
+        // acq_rel: 다른 head가 이 블록에 쓴 결과가 마지막 워커에게 보이도록 한다
+        if (pending[tile].fetch_sub(1, memory_order_acq_rel) != 1) return;
+        int r0 = tile * TILE_Q, r1 = min(r0 + TILE_Q, Rq);
+        for (int g = 0; g < H; ++g)
+            for (int i = r0; i < r1; ++i) kern.axpy(result[i], 1, head_out[g][i], D);
+    });
+}
 
-        cin >> Rk >> C;
-        full_input << Rk << " " << C << "\n";
-        for (int i = 0, x; i < Rk * C; ++i) {
-            cin >> x; full_input << x << " ";
-        }
-        full_input << "\n";
+int main(int argc, char* argv[]) {
+    static const char* const flags[] = {"--shm", "--inproc", nullptr};
+    static const char* const prefixes[] = {"--threads=", "--kernel=", "--output=", nullptr};
+    // --shm: 입력과 결과를 모두 memfd 공유 메모리에 두고, attention_mp가 직접 읽고 쓴다
+    bool shm_mode = has_flag(argc, argv, "--shm");
+    // --inproc: fork/exec 없이 한 프로세스의 스레드 풀에서 모든 head를 계산한다
+    bool inproc_mode = has_flag(argc, argv, "--inproc");
+    const char* threads_opt = find_option(argc, argv, "--threads=");
+    OutputFormat out_fmt;
+    // 위치 인자는 선택: head 수 (benchmark_multi.py가 넘긴다). 주면 입력의 head 수와 같아야 한다.
+    const char* heads_arg = positional_arg(argc, argv);
+    int expected_heads = 0;
+    // 스레드 예산 (--threads, 기본은 하드웨어 동시 실행 수)
+    int total_threads = ThreadPool::default_threads();
+    if (!only_known_options(argc, argv, flags, prefixes) || (shm_mode && inproc_mode) ||
+        positional_count(argc, argv) > 1 || (heads_arg && (!parse_int(heads_arg, expected_heads) || expected_heads < 1)) ||
+        (threads_opt && (!parse_int(threads_opt, total_threads) || total_threads < 1)) ||
+        !parse_output_format(find_option(argc, argv, "--output="), out_fmt)) {
+        cerr << "Usage: ./multiHeadAttention [num_heads] [--shm | --inproc] [--threads=N] "
+                "[--kernel=avx512|avx2|sse41|scalar] [--output=text|binary]" << endl;
+        return 1;
+    }
+    const Kernels* kernels = select_kernels(kernel_option(argc, argv));
+    if (!kernels) {
+        cerr << "Unsupported kernel: " << kernel_option(argc, argv) << endl;
+        return 1;
+    }
 
-        cin >> Rk >> D;
-        full_input << Rk << " " << D << "\n";
-        for (int i = 0, x; i < Rk * D; ++i) {
-            cin >> x; full_input << x << " ";
-        }
-        full_input << "\n";
+    // 입력을 한 번만 읽어 head별 행렬로 만든다 (텍스트 또는 바이너리 텐서 파일)
+    InputBuffer input;
+    vector<HeadInput> heads;
+    if (!input.load(STDIN_FILENO) || !load_heads(input, true, heads)) {
+        cerr << "Invalid input" << endl;
+        return 1;
     }
+    int H = heads.size();
+    if (expected_heads != 0 && expected_heads != H) {
+        cerr << "Head count mismatch: " << expected_heads << " given, " << H << " in input" << endl;
+        return 1;
+    }
+    Rq = heads[H - 1].Q.rows(); C = heads[H - 1].Q.cols();
+    Rk = heads[H - 1].K.rows(); D = heads[H - 1].V.cols();
+
+    if (inproc_mode) {
+        ThreadPool pool(total_threads);
+        Matrix<int> result(Rq, D);
 
-    string all_input = full_input.str();
+        auto start = chrono::high_resolution_clock::now();
+        run_inproc(heads, result, pool, *kernels);
+        auto end = chrono::high_resolution_clock::now();
+
+        write_result(STDOUT_FILENO, out_fmt, chrono::duration_cast<chrono::milliseconds>(end - start).count(),
+                     result);
+        return 0;
+    }
+
+    // 자식에게는 텍스트 대신 바이너리 텐서 형식으로 전달 (재파싱 없음)
+    string serialized;
+    const char* all_input = input.data();
+    size_t all_input_size = input.size();
+    if (!is_tensor_file(input.data(), input.size())) {
+        serialize_tensor_file(heads, serialized);
+        all_input = serialized.data();
+        all_input_size = serialized.size();
+    }
     int matrix_size = Rq * D;
     int shm_total_size = H * matrix_size * sizeof(int);
 
     // 공유 메모리 설정
-    int* shm_base = (int*) mmap(nullptr, shm_total_size, PROT_READ | PROT_WRITE,
-                                MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    int* shm_base = nullptr;
+    int in_fd = -1, out_fd = -1;
+    if (shm_mode) {
+        // 입력은 memfd에 한 번만 기록하고, 모든 worker가 같은 페이지를 mmap해서 읽는다.
+        // 결과 영역도 memfd로 만들어 exec된 attention_mp가 자기 head 구간에 바로 쓴다.
+        in_fd = memfd_create("mha_input", 0);
+        out_fd = memfd_create("mha_result", 0);
+        if (in_fd < 0 || out_fd < 0 || ftruncate(in_fd, all_input_size) != 0 ||
+            ftruncate(out_fd, shm_total_size) != 0) {
+            perror("memfd_create");
+            return 1;
+        }
+        void* in_map = mmap(nullptr, all_input_size, PROT_READ | PROT_WRITE, MAP_SHARED, in_fd, 0);
+        if (in_map == MAP_FAILED) {
+            perror("mmap");
+            return 1;
+        }
+        memcpy(in_map, all_input, all_input_size);
+        munmap(in_map, all_input_size);
+        shm_base = (int*) mmap(nullptr, shm_total_size, PROT_READ | PROT_WRITE,
+                               MAP_SHARED, out_fd, 0);
+    } else {
+        shm_base = (int*) mmap(nullptr, shm_total_size, PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    }
     memset(shm_base, 0, shm_total_size);
 
+    // H개 worker가 동시에 돌므로 스레드 예산을 head끼리 나눈다.
+    // 각자 전체 코어 수만큼 띄우면 H x ncpu 스레드가 ncpu 코어를 두고 다툰다.
+    int head_threads = max(1, total_threads / H);
+    string child_threads = "--threads=" + to_string(head_threads);
+
     auto start = chrono::high_resolution_clock::now();
     vector<pid_t> pids(H);
 
     for (int h = 0; h < H; ++h) {
+        if (shm_mode) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                // 자식: memfd 입력을 stdin으로 두고 바로 exec (파이프, 텍스트 왕복 없음)
+                dup2(in_fd, STDIN_FILENO);
+                string out_opt = "--out-fd=" + to_string(out_fd);
+                execlp("./attention_mp", "./attention_mp", to_string(h).c_str(), out_opt.c_str(),
+                       child_threads.c_str(), nullptr);
+                perror("exec failed");
+                exit(1);
+            }
+            pids[h] = pid;
+            continue;
+        }
+
         int pipefd[2];
         (void)pipe(pipefd);
 
@@ -81,51 +191,67 @@ int main() {
                 // 손자: stdout 파이프 연결 후 exec
                 dup2(outpipe[1], STDOUT_FILENO);
                 close(outpipe[0]);
-                execlp("./attention_mp", "./attention_mp", to_string(h).c_str(), nullptr);
+                execlp("./attention_mp", "./attention_mp", to_string(h).c_str(), "--output=binary",
+                       child_threads.c_str(), nullptr);
                 perror("exec failed");
                 exit(1);
             } else {
-                // 자식: 손자 결과 수신 후 공유 메모리에 저장
+                // 자식: 손자의 바이너리 결과를 받아 공유 메모리에 저장 (텍스트 파싱 없음)
                 close(outpipe[1]);
-                FILE* f = fdopen(outpipe[0], "r");
-                int dummy_latency;
-                (void)fscanf(f, "%d", &dummy_latency);
-                int* shm_ptr = shm_base + h * matrix_size;
-                for (int i = 0; i < matrix_size; ++i) {
-                    (void)fscanf(f, "%d", &shm_ptr[i]);
+                InputBuffer out;
+                TensorFileHeader hdr;
+                vector<Matrix<int>> mats;
+                bool ok = out.load(outpipe[0]) && read_tensors(out.data(), out.size(), hdr, mats) &&
+                          mats.size() == 1 && mats[0].rows() == Rq && mats[0].cols() == D;
+                close(outpipe[0]);
+                if (ok) {
+                    int* shm_ptr = shm_base + h * matrix_size;
+                    for (int i = 0; i < Rq; ++i) memcpy(shm_ptr + i * D, mats[0][i], D * sizeof(int));
                 }
-                fclose(f);
-                waitpid(grandchild, nullptr, 0);
-                exit(0);
+                int status;
+                pid_t r;
+                while ((r = waitpid(grandchild, &status, 0)) < 0 && errno == EINTR) {}
+                ok = ok && r == grandchild && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+                exit(ok ? 0 : 1);
             }
         } else {
             // 부모: 자식에게 입력 전달
             close(pipefd[0]);
-            (void)write(pipefd[1], all_input.c_str(), all_input.size());
+            (void)write_all(pipefd[1], all_input, all_input_size);
             close(pipefd[1]);
             pids[h] = pid;
         }
     }
 
-    // 모든 자식 종료 대기
-    for (pid_t pid : pids)
-        waitpid(pid, nullptr, 0);
-
-    auto end = chrono::high_resolution_clock::now();
-    int latency = chrono::duration_cast<chrono::milliseconds>(end - start).count();
+    // 자식을 모두 띄운 뒤에 풀을 만든다 (스레드가 있는 상태로 fork하지 않도록).
+    // 합산은 끝난 worker의 몫을 이어 쓰므로 head 하나의 몫만큼만 둔다 (다른 worker가 아직 돈다).
+    ThreadPool pool(head_threads);
+    Matrix<int> result(Rq, D);
 
-    // 최종 결과 합산 및 출력
-    vector<vector<int>> result(Rq, vector<int>(D, 0));
-    for (int h = 0; h < H; ++h) {
-        int* shm_ptr = shm_base + h * matrix_size;
-        add_to_result(shm_ptr, result);
+    // 끝난 순서대로 head 결과를 병렬 합산: 아직 실행 중인 head와 합산이 겹친다.
+    // 정상 종료(코드 0)하지 않은 worker가 있으면 그 head의 결과 구간은 믿을 수 없으므로 실패한다.
+    for (int done = 0; done < H;) {
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            perror("waitpid");
+            return 1;
+        }
+        int h = find(pids.begin(), pids.end(), pid) - pids.begin();
+        if (h == H) continue;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            cerr << "Worker for head " << h << " failed" << endl;
+            return 1;
+        }
+        add_to_result(shm_base + (size_t)h * matrix_size, result, pool, *kernels);
+        ++done;
     }
 
-    cout << latency << endl;
-    for (auto& row : result) {
-        for (int x : row) cout << x << " ";
-        cout << "\n";
-    }
+    auto end = chrono::high_resolution_clock::now();
+    int latency = chrono::duration_cast<chrono::milliseconds>(end - start).count();
 
+    // 출력 형식: 시간 + 결과 행렬
+    write_result(STDOUT_FILENO, out_fmt, latency, result);
     return 0;
 }
@@ -0,0 +1,64 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+
+// argv에서 "prefix값" 형태의 옵션을 찾아 값 부분을 반환 (없으면 nullptr)
+inline const char* find_option(int argc, char* argv[], const char* prefix) {
+    size_t len = std::strlen(prefix);
+    for (int i = 1; i < argc; ++i)
+        if (std::strncmp(argv[i], prefix, len) == 0) return argv[i] + len;
+    return nullptr;
+}
+
+// 값 없는 플래그가 정확히 그 이름으로 있는지 (--shm이 --shmfoo와 맞지 않도록 전체를 비교)
+inline bool has_flag(int argc, char* argv[], const char* flag) {
+    for (int i = 1; i < argc; ++i)
+        if (std::strcmp(argv[i], flag) == 0) return true;
+    return false;
+}
+
+// "--"로 시작하는 인자가 모두 flags의 플래그이거나 prefixes로 시작하는 "prefix값" 옵션인지
+// (두 목록은 nullptr로 끝난다. 위치 인자는 positional_count로 따로 센다)
+inline bool only_known_options(int argc, char* argv[], const char* const flags[], const char* const prefixes[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--", 2) != 0) continue;
+        bool known = false;
+        for (int f = 0; flags[f] && !known; ++f) known = std::strcmp(argv[i], flags[f]) == 0;
+        for (int p = 0; prefixes[p] && !known; ++p)
+            known = std::strncmp(argv[i], prefixes[p], std::strlen(prefixes[p])) == 0;
+        if (!known) return false;
+    }
+    return true;
+}
+
+// "--"로 시작하지 않는 인자(위치 인자) 수
+inline int positional_count(int argc, char* argv[]) {
+    int n = 0;
+    for (int i = 1; i < argc; ++i)
+        if (std::strncmp(argv[i], "--", 2) != 0) ++n;
+    return n;
+}
+
+// 첫 번째 위치 인자 (없으면 nullptr). 옵션은 위치 인자 앞뒤 어디에나 올 수 있다.
+inline const char* positional_arg(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i)
+        if (std::strncmp(argv[i], "--", 2) != 0) return argv[i];
+    return nullptr;
+}
+
+// 문자열 전체를 10진 정수로 해석 (비었거나 숫자가 아닌 문자가 있거나 int 범위를 넘으면 false)
+inline bool parse_int(const char* text, int& value) {
+    if (!text || !*text) return false;
+    char* end;
+    errno = 0;
+    long v = std::strtol(text, &end, 10);
+    if (*end != '\0' || errno == ERANGE || v < INT_MIN || v > INT_MAX) return false;
+    value = (int)v;
+    return true;
+}
+
+#endif
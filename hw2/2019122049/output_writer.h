@@ -0,0 +1,95 @@
+#ifndef OUTPUT_WRITER_H
+#define OUTPUT_WRITER_H
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "matrix.h"
+#include "tensor_io.h"
+
+// iostream 대신 쓰는 버퍼 출력기: 정수를 직접 텍스트로 바꿔 큰 블록 단위로 write(2)한다.
+class OutputWriter {
+public:
+    explicit OutputWriter(int fd, size_t capacity = 1 << 20) : fd(fd), buf(capacity), len(0), failed(false) {}
+    ~OutputWriter() { flush(); }
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    void put(char c) {
+        if (len == buf.size()) flush();
+        buf[len++] = c;
+    }
+
+    void put_int(int x) {
+        if (buf.size() - len < 12) flush();  // 부호 + 10자리 + 여유
+        char tmp[12];
+        int n = 0;
+        unsigned v = x < 0 ? 0u - (unsigned)x : (unsigned)x;
+        do { tmp[n++] = (char)('0' + v % 10); v /= 10; } while (v);
+        if (x < 0) buf[len++] = '-';
+        while (n) buf[len++] = tmp[--n];
+    }
+
+    void put_bytes(const char* p, size_t n) {
+        if (n >= buf.size()) {
+            flush();
+            if (!write_all(fd, p, n)) failed = true;
+            return;
+        }
+        if (buf.size() - len < n) flush();
+        std::memcpy(&buf[len], p, n);
+        len += n;
+    }
+
+    bool flush() {
+        if (len > 0 && !write_all(fd, buf.data(), len)) failed = true;
+        len = 0;
+        return !failed;
+    }
+
+    bool ok() const { return !failed; }
+
+private:
+    int fd;
+    std::vector<char> buf;
+    size_t len;
+    bool failed;
+};
+
+// 출력 형식
+//   text  : 첫 줄 latency, 이후 행마다 "x x x ... \n" (기존 cout 출력과 바이트 단위 동일)
+//   binary: 입력과 같은 텐서 파일 형식, heads = 0, count = 1, aux = latency
+enum OutputFormat { OUTPUT_TEXT, OUTPUT_BINARY };
+
+// "--output=text|binary" 값 해석 (nullptr이면 text). 알 수 없는 값이면 false.
+inline bool parse_output_format(const char* value, OutputFormat& fmt) {
+    fmt = OUTPUT_TEXT;
+    if (!value || std::strcmp(value, "text") == 0) return true;
+    if (std::strcmp(value, "binary") == 0) { fmt = OUTPUT_BINARY; return true; }
+    return false;
+}
+
+inline bool write_result(int fd, OutputFormat fmt, int latency, const Matrix<int>& result) {
+    if (fmt == OUTPUT_BINARY) {
+        std::string out;
+        std::vector<const Matrix<int>*> mats(1, &result);
+        serialize_tensors(mats, 0, (uint32_t)latency, out);
+        return write_all(fd, out.data(), out.size());
+    }
+
+    OutputWriter w(fd);
+    w.put_int(latency);
+    w.put('\n');
+    for (int i = 0; i < result.rows(); ++i) {
+        const int* row = result[i];
+        for (int j = 0; j < result.cols(); ++j) {
+            w.put_int(row[j]);
+            w.put(' ');
+        }
+        w.put('\n');
+    }
+    return w.flush();
+}
+
+#endif
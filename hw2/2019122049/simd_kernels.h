@@ -0,0 +1,187 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <cstring>
+#include <cstdint>
+#include "options.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_X86 1
+#endif
+
+// attention 내부 루프의 두 정수 커널.
+//   dot : sum(a[k] * b[k])      (Q[i] · K[j])
+//   axpy: y[d] += alpha * x[d]  (result[i] += dot * V[j])
+// 모든 구현은 32비트 정수 wrap-around 규칙을 따르므로 결과가 서로 동일하다.
+typedef int (*dot_fn)(const int* a, const int* b, int n);
+typedef void (*axpy_fn)(int* y, int alpha, const int* x, int n);
+
+struct Kernels {
+    const char* name;
+    dot_fn dot;
+    axpy_fn axpy;
+};
+
+// ---- scalar ----
+static int dot_scalar(const int* a, const int* b, int n) {
+    int s = 0;
+    for (int k = 0; k < n; ++k) s += a[k] * b[k];
+    return s;
+}
+
+static void axpy_scalar(int* y, int alpha, const int* x, int n) {
+    for (int d = 0; d < n; ++d) y[d] += alpha * x[d];
+}
+
+#ifdef SIMD_X86
+// ---- SSE4.1 (4 x int32) ----
+__attribute__((target("sse4.1")))
+static int dot_sse41(const int* a, const int* b, int n) {
+    __m128i acc = _mm_setzero_si128();
+    int k = 0;
+    for (; k + 4 <= n; k += 4) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + k));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + k));
+        acc = _mm_add_epi32(acc, _mm_mullo_epi32(va, vb));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    int s = _mm_cvtsi128_si32(acc);
+    for (; k < n; ++k) s += a[k] * b[k];
+    return s;
+}
+
+__attribute__((target("sse4.1")))
+static void axpy_sse41(int* y, int alpha, const int* x, int n) {
+    __m128i va = _mm_set1_epi32(alpha);
+    int d = 0;
+    for (; d + 4 <= n; d += 4) {
+        __m128i vy = _mm_loadu_si128((const __m128i*)(y + d));
+        __m128i vx = _mm_loadu_si128((const __m128i*)(x + d));
+        _mm_storeu_si128((__m128i*)(y + d), _mm_add_epi32(vy, _mm_mullo_epi32(va, vx)));
+    }
+    for (; d < n; ++d) y[d] += alpha * x[d];
+}
+
+// ---- AVX2 (8 x int32) ----
+__attribute__((target("avx2")))
+static int dot_avx2(const int* a, const int* b, int n) {
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    int k = 0;
+    for (; k + 16 <= n; k += 16) {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(a + k));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(b + k));
+        __m256i a1 = _mm256_loadu_si256((const __m256i*)(a + k + 8));
+        __m256i b1 = _mm256_loadu_si256((const __m256i*)(b + k + 8));
+        acc0 = _mm256_add_epi32(acc0, _mm256_mullo_epi32(a0, b0));
+        acc1 = _mm256_add_epi32(acc1, _mm256_mullo_epi32(a1, b1));
+    }
+    for (; k + 8 <= n; k += 8) {
+        __m256i a0 = _mm256_loadu_si256((const __m256i*)(a + k));
+        __m256i b0 = _mm256_loadu_si256((const __m256i*)(b + k));
+        acc0 = _mm256_add_epi32(acc0, _mm256_mullo_epi32(a0, b0));
+    }
+    acc0 = _mm256_add_epi32(acc0, acc1);
+    __m128i s4 = _mm_add_epi32(_mm256_castsi256_si128(acc0), _mm256_extracti128_si256(acc0, 1));
+    s4 = _mm_add_epi32(s4, _mm_shuffle_epi32(s4, _MM_SHUFFLE(1, 0, 3, 2)));
+    s4 = _mm_add_epi32(s4, _mm_shuffle_epi32(s4, _MM_SHUFFLE(2, 3, 0, 1)));
+    int s = _mm_cvtsi128_si32(s4);
+    for (; k < n; ++k) s += a[k] * b[k];
+    return s;
+}
+
+__attribute__((target("avx2")))
+static void axpy_avx2(int* y, int alpha, const int* x, int n) {
+    __m256i va = _mm256_set1_epi32(alpha);
+    int d = 0;
+    for (; d + 8 <= n; d += 8) {
+        __m256i vy = _mm256_loadu_si256((const __m256i*)(y + d));
+        __m256i vx = _mm256_loadu_si256((const __m256i*)(x + d));
+        _mm256_storeu_si256((__m256i*)(y + d), _mm256_add_epi32(vy, _mm256_mullo_epi32(va, vx)));
+    }
+    for (; d < n; ++d) y[d] += alpha * x[d];
+}
+
+// ---- AVX-512F (16 x int32), 꼬리는 마스크 로드로 처리 ----
+__attribute__((target("avx512f")))
+static int dot_avx512(const int* a, const int* b, int n) {
+    __m512i acc = _mm512_setzero_si512();
+    int k = 0;
+    for (; k + 16 <= n; k += 16) {
+        __m512i va = _mm512_loadu_si512((const void*)(a + k));
+        __m512i vb = _mm512_loadu_si512((const void*)(b + k));
+        acc = _mm512_add_epi32(acc, _mm512_mullo_epi32(va, vb));
+    }
+    if (k < n) {
+        __mmask16 m = (__mmask16)((1u << (n - k)) - 1);
+        __m512i va = _mm512_maskz_loadu_epi32(m, a + k);
+        __m512i vb = _mm512_maskz_loadu_epi32(m, b + k);
+        acc = _mm512_add_epi32(acc, _mm512_mullo_epi32(va, vb));
+    }
+    alignas(64) int lanes[16];
+    _mm512_store_si512((void*)lanes, acc);
+    int s = 0;
+    for (int l = 0; l < 16; ++l) s += lanes[l];
+    return s;
+}
+
+__attribute__((target("avx512f")))
+static void axpy_avx512(int* y, int alpha, const int* x, int n) {
+    __m512i va = _mm512_set1_epi32(alpha);
+    int d = 0;
+    for (; d + 16 <= n; d += 16) {
+        __m512i vy = _mm512_loadu_si512((const void*)(y + d));
+        __m512i vx = _mm512_loadu_si512((const void*)(x + d));
+        _mm512_storeu_si512((void*)(y + d), _mm512_add_epi32(vy, _mm512_mullo_epi32(va, vx)));
+    }
+    if (d < n) {
+        __mmask16 m = (__mmask16)((1u << (n - d)) - 1);
+        __m512i vy = _mm512_maskz_loadu_epi32(m, y + d);
+        __m512i vx = _mm512_maskz_loadu_epi32(m, x + d);
+        _mm512_mask_storeu_epi32(y + d, m, _mm512_add_epi32(vy, _mm512_mullo_epi32(va, vx)));
+    }
+}
+#endif
+
+// 사용 가능한 커널 목록 (빠른 순서)
+static const Kernels KERNEL_TABLE[] = {
+#ifdef SIMD_X86
+    {"avx512", dot_avx512, axpy_avx512},
+    {"avx2", dot_avx2, axpy_avx2},
+    {"sse41", dot_sse41, axpy_sse41},
+#endif
+    {"scalar", dot_scalar, axpy_scalar},
+};
+static const int KERNEL_COUNT = sizeof(KERNEL_TABLE) / sizeof(KERNEL_TABLE[0]);
+
+// 현재 CPU에서 해당 커널을 실행할 수 있는지 CPUID로 확인
+inline bool kernel_supported(const Kernels& k) {
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+    if (std::strcmp(k.name, "avx512") == 0) return __builtin_cpu_supports("avx512f");
+    if (std::strcmp(k.name, "avx2") == 0) return __builtin_cpu_supports("avx2");
+    if (std::strcmp(k.name, "sse41") == 0) return __builtin_cpu_supports("sse4.1");
+#endif
+    return std::strcmp(k.name, "scalar") == 0;
+}
+
+// 시작 시 한 번 호출: name이 nullptr이면 지원되는 가장 빠른 커널을,
+// 아니면 해당 이름의 커널을 반환한다. 이름이 없거나 지원되지 않으면 nullptr.
+inline const Kernels* select_kernels(const char* name) {
+    for (int i = 0; i < KERNEL_COUNT; ++i) {
+        const Kernels& k = KERNEL_TABLE[i];
+        if (name && std::strcmp(name, k.name) != 0) continue;
+        if (kernel_supported(k)) return &k;
+        if (name) return nullptr;
+    }
+    return nullptr;
+}
+
+// argv에서 "--kernel=이름" 옵션을 찾아 이름을 반환 (없으면 nullptr)
+inline const char* kernel_option(int argc, char* argv[]) {
+    return find_option(argc, argv, "--kernel=");
+}
+
+#endif
@@ -0,0 +1,265 @@
+#ifndef TENSOR_IO_H
+#define TENSOR_IO_H
+
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "matrix.h"
+
+// 바이너리 텐서 파일 형식 (리틀 엔디언)
+//   TensorFileHeader (32 bytes)
+//   TensorDesc x count (입력 파일: count = heads * 3, head마다 Q, K, V 순서
+//                      출력 파일: heads = 0, count = 1, aux = latency(ms))
+//   payload: 각 텐서는 64바이트 경계의 offset에서 시작하고, 행은 stride개 원소 간격으로 저장
+// payload 정렬과 stride가 Matrix<int>와 같으므로 mmap한 파일을 복사 없이 행렬로 쓸 수 있다.
+const char TENSOR_MAGIC[4] = {'T', 'N', 'S', 'R'};
+const uint32_t TENSOR_VERSION = 1;
+const uint32_t TENSOR_DTYPE_I32 = 0;
+const size_t TENSOR_ALIGN = 64;
+
+struct TensorFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t dtype;
+    uint32_t heads;
+    uint32_t count;
+    uint32_t aux;
+    uint32_t reserved[2];
+};
+
+struct TensorDesc {
+    uint32_t rows, cols;
+    uint64_t stride;  // 원소 단위 행 간격
+    uint64_t offset;  // 파일 시작 기준 payload 바이트 offset
+};
+
+// head 하나의 입력
+struct HeadInput {
+    Matrix<int> Q, K, V;
+};
+
+// 입력 전체를 담는 버퍼. 일반 파일이면 mmap, 파이프면 정렬된 버퍼로 모두 읽는다.
+class InputBuffer {
+public:
+    InputBuffer() : ptr(nullptr), len(0), mapped(false) {}
+    ~InputBuffer() {
+        if (mapped) munmap(ptr, len);
+        else std::free(ptr);
+    }
+    InputBuffer(const InputBuffer&) = delete;
+    InputBuffer& operator=(const InputBuffer&) = delete;
+
+    bool load(int fd) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            off_t pos = lseek(fd, 0, SEEK_CUR);
+            if (pos == 0) {
+                // 쓰기는 copy-on-write로만 일어나므로 원본 파일은 바뀌지 않는다
+                void* p = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    ptr = (char*)p; len = st.st_size; mapped = true;
+                    return true;
+                }
+            }
+        }
+        size_t cap = 1 << 20;
+        if (posix_memalign((void**)&ptr, TENSOR_ALIGN, cap) != 0) return false;
+        for (;;) {
+            if (len == cap) {
+                void* bigger = nullptr;
+                if (posix_memalign(&bigger, TENSOR_ALIGN, cap * 2) != 0) return false;
+                std::memcpy(bigger, ptr, len);
+                std::free(ptr);
+                ptr = (char*)bigger; cap *= 2;
+            }
+            ssize_t n = read(fd, ptr + len, cap - len);
+            if (n < 0) return false;
+            if (n == 0) break;
+            len += n;
+        }
+        return true;
+    }
+
+    char* data() const { return ptr; }
+    size_t size() const { return len; }
+
+private:
+    char* ptr;
+    size_t len;
+    bool mapped;
+};
+
+inline bool is_tensor_file(const char* data, size_t size) {
+    return size >= sizeof(TensorFileHeader) && std::memcmp(data, TENSOR_MAGIC, 4) == 0;
+}
+
+// 바이너리 텐서 파일의 텐서들을 버퍼를 빌린 행렬로 만든다 (복사 없음).
+inline bool read_tensors(char* data, size_t size, TensorFileHeader& hdr, std::vector<Matrix<int>>& mats) {
+    if (!is_tensor_file(data, size)) return false;
+    std::memcpy(&hdr, data, sizeof(hdr));
+    if (hdr.version != TENSOR_VERSION || hdr.dtype != TENSOR_DTYPE_I32) return false;
+    if (sizeof(hdr) + (size_t)hdr.count * sizeof(TensorDesc) > size) return false;
+
+    const TensorDesc* desc = (const TensorDesc*)(data + sizeof(hdr));
+    mats.clear();
+    for (uint32_t t = 0; t < hdr.count; ++t) {
+        const TensorDesc& d = desc[t];
+        if (d.rows > INT_MAX || d.cols > INT_MAX) return false;
+        if (d.offset % TENSOR_ALIGN != 0 || d.stride < d.cols) return false;
+        // 헤더 값이 커도 곱이 넘쳐 크기 검사를 통과하지 않도록 검사하며 계산한다
+        uint64_t bytes, tensor_end;
+        if (__builtin_mul_overflow((uint64_t)d.rows, d.stride, &bytes) ||
+            __builtin_mul_overflow(bytes, (uint64_t)sizeof(int), &bytes) ||
+            __builtin_add_overflow(d.offset, bytes, &tensor_end) || tensor_end > size)
+            return false;
+        mats.push_back(Matrix<int>::borrow((int*)(data + d.offset), d.rows, d.cols, d.stride));
+    }
+    return true;
+}
+
+// 입력 텐서 파일을 head별 Q/K/V로 나눈다.
+inline bool read_tensor_file(char* data, size_t size, std::vector<HeadInput>& heads) {
+    TensorFileHeader hdr;
+    std::vector<Matrix<int>> mats;
+    if (!read_tensors(data, size, hdr, mats) || hdr.count != (uint64_t)hdr.heads * 3) return false;
+    heads.clear();
+    heads.resize(hdr.heads);
+    for (uint32_t h = 0; h < hdr.heads; ++h) {
+        heads[h].Q = std::move(mats[h * 3]);
+        heads[h].K = std::move(mats[h * 3 + 1]);
+        heads[h].V = std::move(mats[h * 3 + 2]);
+    }
+    return true;
+}
+
+// iostream 대신 쓰는 정수 텍스트 파서
+class TextScanner {
+public:
+    TextScanner(const char* data, size_t size) : p(data), end(data + size) {}
+
+    bool next(int& out) {
+        while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) ++p;
+        if (p == end) return false;
+        bool neg = false;
+        if (*p == '-' || *p == '+') { neg = (*p == '-'); ++p; }
+        if (p == end || *p < '0' || *p > '9') return false;
+        unsigned v = 0;
+        while (p < end && *p >= '0' && *p <= '9') v = v * 10 + (unsigned)(*p++ - '0');
+        out = neg ? (int)(0u - v) : (int)v;
+        return true;
+    }
+
+    // "rows cols" 헤더와 원소들을 읽어 m에 채운다
+    bool matrix(Matrix<int>& m) {
+        int r, c;
+        if (!next(r) || !next(c) || r < 0 || c < 0) return false;
+        m.assign(r, c);
+        for (int i = 0; i < r; ++i) {
+            int* row = m[i];
+            for (int j = 0; j < c; ++j)
+                if (!next(row[j])) return false;
+        }
+        return true;
+    }
+
+    bool head(HeadInput& h) { return matrix(h.Q) && matrix(h.K) && matrix(h.V); }
+
+private:
+    const char* p;
+    const char* end;
+};
+
+// head들의 모양이 attention에 맞는지 확인한다: head마다 Q.cols == K.cols, K.rows == V.rows이고,
+// 결과를 한 행렬(Rq x D)에 합산하므로 모든 head의 Rq와 D가 같아야 한다.
+// H개 결과를 int 크기로 한 번에 잡는 호출자가 있으므로 전체 결과 바이트 수도 int에 들어가야 한다.
+inline bool heads_consistent(const std::vector<HeadInput>& heads) {
+    if (heads.empty()) return false;
+    int Rq = heads[0].Q.rows(), D = heads[0].V.cols();
+    for (const HeadInput& h : heads) {
+        if (h.Q.cols() != h.K.cols() || h.K.rows() != h.V.rows()) return false;
+        if (h.Q.rows() != Rq || h.V.cols() != D) return false;
+    }
+    int64_t total;
+    if (__builtin_mul_overflow((int64_t)heads.size(), (int64_t)Rq, &total) ||
+        __builtin_mul_overflow(total, (int64_t)D * (int64_t)sizeof(int), &total) || total > INT_MAX)
+        return false;
+    return true;
+}
+
+// 입력을 head 목록으로 읽는다. 바이너리면 mmap 버퍼를 그대로 쓰고, 텍스트면 파싱한다.
+// 어느 쪽이든 모양이 맞지 않으면 false.
+// multi_head가 false인 텍스트 입력은 H 없이 Q, K, V만 있는 단일 head 형식이다.
+inline bool load_heads(const InputBuffer& in, bool multi_head, std::vector<HeadInput>& heads) {
+    if (is_tensor_file(in.data(), in.size()))
+        return read_tensor_file(in.data(), in.size(), heads) && heads_consistent(heads);
+
+    TextScanner sc(in.data(), in.size());
+    int H = 1;
+    if (multi_head && (!sc.next(H) || H <= 0)) return false;
+    heads.clear();
+    heads.resize(H);
+    for (int h = 0; h < H; ++h)
+        if (!sc.head(heads[h])) return false;
+    return heads_consistent(heads);
+}
+
+// 행렬들을 바이너리 텐서 파일 형식으로 직렬화한다.
+inline void serialize_tensors(const std::vector<const Matrix<int>*>& mats, uint32_t heads, uint32_t aux,
+                              std::string& out) {
+    TensorFileHeader hdr;
+    std::memset(&hdr, 0, sizeof(hdr));
+    std::memcpy(hdr.magic, TENSOR_MAGIC, 4);
+    hdr.version = TENSOR_VERSION;
+    hdr.dtype = TENSOR_DTYPE_I32;
+    hdr.heads = heads;
+    hdr.count = mats.size();
+    hdr.aux = aux;
+
+    std::vector<TensorDesc> desc(mats.size());
+    uint64_t off = sizeof(hdr) + desc.size() * sizeof(TensorDesc);
+    for (size_t t = 0; t < mats.size(); ++t) {
+        off = (off + TENSOR_ALIGN - 1) / TENSOR_ALIGN * TENSOR_ALIGN;
+        desc[t].rows = mats[t]->rows();
+        desc[t].cols = mats[t]->cols();
+        desc[t].stride = Matrix<int>::stride_for(mats[t]->cols());
+        desc[t].offset = off;
+        off += (uint64_t)desc[t].rows * desc[t].stride * sizeof(int);
+    }
+
+    out.assign(off, '\0');
+    std::memcpy(&out[0], &hdr, sizeof(hdr));
+    std::memcpy(&out[sizeof(hdr)], desc.data(), desc.size() * sizeof(TensorDesc));
+    for (size_t t = 0; t < mats.size(); ++t) {
+        const Matrix<int>& m = *mats[t];
+        for (int i = 0; i < m.rows(); ++i)
+            std::memcpy(&out[desc[t].offset + (uint64_t)i * desc[t].stride * sizeof(int)], m[i],
+                        m.cols() * sizeof(int));
+    }
+}
+
+// head 목록을 입력 텐서 파일 형식으로 직렬화한다.
+inline void serialize_tensor_file(const std::vector<HeadInput>& heads, std::string& out) {
+    std::vector<const Matrix<int>*> mats;
+    for (const HeadInput& h : heads) {
+        mats.push_back(&h.Q); mats.push_back(&h.K); mats.push_back(&h.V);
+    }
+    serialize_tensors(mats, heads.size(), 0, out);
+}
+
+// fd에 버퍼 전체를 쓴다 (부분 쓰기 반복)
+inline bool write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n <= 0) return false;
+        data += n; size -= n;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <deque>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+
+// 재사용 가능한 스레드 풀.
+// 워커마다 자기 작업 deque를 가지며, 자기 deque의 앞에서 작업을 꺼내고
+// 비면 다른 워커 deque의 뒤에서 작업을 훔쳐(work stealing) 온다.
+// 작업 단위는 정수 인덱스 [0, n_tasks)이고 parallel_for가 끝날 때까지 호출자는 대기한다.
+class ThreadPool {
+public:
+    // n_threads <= 0 이면 하드웨어 동시 실행 수를 사용
+    explicit ThreadPool(int n_threads = 0) : queues(0), stop(false), generation(0), busy_workers(0) {
+        if (n_threads <= 0) n_threads = default_threads();
+        queues = std::vector<WorkerQueue>(n_threads);
+        pthread_mutex_init(&state_mutex, nullptr);
+        pthread_cond_init(&work_cv, nullptr);
+        pthread_cond_init(&done_cv, nullptr);
+
+        args.resize(n_threads);
+        threads.resize(n_threads);
+        for (int i = 0; i < n_threads; ++i) {
+            args[i].pool = this;
+            args[i].id = i;
+            pthread_create(&threads[i], nullptr, worker_main, &args[i]);
+        }
+    }
+
+    ~ThreadPool() {
+        pthread_mutex_lock(&state_mutex);
+        stop = true;
+        pthread_cond_broadcast(&work_cv);
+        pthread_mutex_unlock(&state_mutex);
+        for (auto& t : threads) pthread_join(t, nullptr);
+        pthread_cond_destroy(&work_cv);
+        pthread_cond_destroy(&done_cv);
+        pthread_mutex_destroy(&state_mutex);
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return (int)queues.size(); }
+
+    static int default_threads() {
+        int n = (int)std::thread::hardware_concurrency();
+        return n > 0 ? n : 1;
+    }
+
+    // fn(0) ... fn(n_tasks - 1)을 풀에서 실행하고 모두 끝나면 반환한다.
+    // 초기 분배는 워커마다 연속 구간이며, 남는 워커가 나머지를 훔쳐 간다.
+    void parallel_for(int n_tasks, const std::function<void(int)>& fn) {
+        if (n_tasks <= 0) return;
+        int n = size();
+        int per = n_tasks / n, rem = n_tasks % n, curr = 0;
+        for (int w = 0; w < n; ++w) {
+            int cnt = per + (w < rem ? 1 : 0);
+            pthread_mutex_lock(&queues[w].m);
+            for (int t = curr; t < curr + cnt; ++t) queues[w].q.push_back(t);
+            pthread_mutex_unlock(&queues[w].m);
+            curr += cnt;
+        }
+
+        pthread_mutex_lock(&state_mutex);
+        task = &fn;
+        busy_workers = n;
+        ++generation;
+        pthread_cond_broadcast(&work_cv);
+        while (busy_workers > 0) pthread_cond_wait(&done_cv, &state_mutex);
+        task = nullptr;
+        pthread_mutex_unlock(&state_mutex);
+    }
+
+private:
+    // 워커별 작업 큐 (false sharing 방지를 위해 캐시 라인만큼 패딩)
+    struct WorkerQueue {
+        pthread_mutex_t m;
+        std::deque<int> q;
+        char pad[64];
+        WorkerQueue() { pthread_mutex_init(&m, nullptr); }
+        WorkerQueue(const WorkerQueue&) { pthread_mutex_init(&m, nullptr); }
+        ~WorkerQueue() { pthread_mutex_destroy(&m); }
+    };
+
+    struct WorkerArg {
+        ThreadPool* pool;
+        int id;
+    };
+
+    std::vector<WorkerQueue> queues;
+    std::vector<WorkerArg> args;
+    std::vector<pthread_t> threads;
+
+    pthread_mutex_t state_mutex;
+    pthread_cond_t work_cv, done_cv;
+    bool stop;
+    unsigned long generation;  // parallel_for 호출마다 증가
+    int busy_workers;          // 아직 작업을 찾고 있는 워커 수
+    const std::function<void(int)>* task = nullptr;
+
+    // 자기 deque 앞에서 꺼내기
+    bool pop_local(int id, int& t) {
+        WorkerQueue& wq = queues[id];
+        pthread_mutex_lock(&wq.m);
+        bool ok = !wq.q.empty();
+        if (ok) { t = wq.q.front(); wq.q.pop_front(); }
+        pthread_mutex_unlock(&wq.m);
+        return ok;
+    }
+
+    // 다른 워커 deque 뒤에서 훔치기
+    bool steal(int id, int& t) {
+        int n = size();
+        for (int k = 1; k < n; ++k) {
+            WorkerQueue& wq = queues[(id + k) % n];
+            pthread_mutex_lock(&wq.m);
+            bool ok = !wq.q.empty();
+            if (ok) { t = wq.q.back(); wq.q.pop_back(); }
+            pthread_mutex_unlock(&wq.m);
+            if (ok) return true;
+        }
+        return false;
+    }
+
+    static void* worker_main(void* p) {
+        WorkerArg* a = (WorkerArg*)p;
+        a->pool->run(a->id);
+        return nullptr;
+    }
+
+    void run(int id) {
+        unsigned long seen = 0;
+        for (;;) {
+            pthread_mutex_lock(&state_mutex);
+            while (!stop && generation == seen) pthread_cond_wait(&work_cv, &state_mutex);
+            if (stop) { pthread_mutex_unlock(&state_mutex); return; }
+            seen = generation;
+            const std::function<void(int)>* fn = task;
+            pthread_mutex_unlock(&state_mutex);
+
+            int t;
+            while (pop_local(id, t) || steal(id, t)) (*fn)(t);
+
+            // 모든 deque가 비었다: 이 워커의 몫은 끝
+            pthread_mutex_lock(&state_mutex);
+            if (--busy_workers == 0) pthread_cond_signal(&done_cv);
+            pthread_mutex_unlock(&state_mutex);
+        }
+    }
+};
+
+#endif
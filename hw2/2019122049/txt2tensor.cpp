@@ -0,0 +1,44 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "tensor_io.h"
+using namespace std;
+
+// 텍스트 입력의 첫 줄 토큰 수로 형식 판별: 1개면 multi-head ("H"), 2개면 단일 head ("Rq C")
+bool looks_multi_head(const char* data, size_t size) {
+    size_t i = 0;
+    while (i < size && (data[i] == ' ' || data[i] == '\n' || data[i] == '\r' || data[i] == '\t')) ++i;
+    int tokens = 0;
+    bool in_token = false;
+    for (; i < size && data[i] != '\n'; ++i) {
+        bool space = (data[i] == ' ' || data[i] == '\t' || data[i] == '\r');
+        if (!space && !in_token) ++tokens;
+        in_token = !space;
+    }
+    return tokens == 1;
+}
+
+// 텍스트 입력(단일 head 또는 multi-head)을 바이너리 텐서 파일로 변환
+int main(int argc, char* argv[]) {
+    (void)argv;
+    if (argc != 1) {
+        cerr << "Usage: ./txt2tensor < input.txt > input.bin" << endl;
+        return 1;
+    }
+
+    InputBuffer input;
+    vector<HeadInput> heads;
+    if (!input.load(STDIN_FILENO) || !load_heads(input, looks_multi_head(input.data(), input.size()), heads)) {
+        cerr << "Invalid input" << endl;
+        return 1;
+    }
+
+    string out;
+    serialize_tensor_file(heads, out);
+    if (!write_all(STDOUT_FILENO, out.data(), out.size())) {
+        cerr << "Write failed" << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -4,12 +4,13 @@ import matplotlib.pyplot as plt
 import pandas as pd
 from tqdm import tqdm
 import os
+import sys
 import tempfile
 import seaborn as sns
 sns.set(style="whitegrid")
 
 # 설정
-ATTENTION_EXEC = "./attention"  # 실행 파일 경로
+ATTENTION_EXEC = "./attention"  # 실행 파일 경로 (g++ -std=c++11 -O2 -pthread -o attention attention.cpp: 타일링 + SIMD 커널)
 TRIALS = 3  # 반복 횟수
 
 # 입력 생성
@@ -68,6 +69,19 @@ def size_experiment(threads=4, sizes=range(100, 1100, 100)):
     
     return pd.DataFrame(results, columns=["Size (R=C)", "Latency (ms)"])
 
+# 2019122049/bench_attention (C++) 결과 CSV 불러오기
+# 커널 하나를 골라 기존 그래프 함수가 쓰는 열(Threads / Size (R=C) / Latency (ms))만 남긴다.
+def load_native_results(csv_path, kernel=None):
+    df = pd.read_csv(csv_path)
+    if kernel is None:
+        kernel = df["Kernel"].iloc[0]
+    df = df[df["Kernel"] == kernel]
+    size = df["Size (R=C)"].min()
+    threads = df["Threads"].min()
+    df_threads = df[df["Size (R=C)"] == size][["Threads", "Latency (ms)"]].reset_index(drop=True)
+    df_sizes = df[df["Threads"] == threads][["Size (R=C)", "Latency (ms)"]].reset_index(drop=True)
+    return df_threads, df_sizes
+
 # 그래프 저장
 def save_thread_latency_plot(df, filename="thread_vs_latency.png"):
     plt.figure(figsize=(7, 5))
@@ -121,8 +135,12 @@ def save_latency_table_image_separately(df1, df2, filename1="latency_table_threa
 
 # 실행
 if __name__ == "__main__":
-    df_threads = thread_experiment()
-    df_sizes = size_experiment()
+    # 사용법: python benchmark_attention.py [bench_attention.csv [kernel]]
+    if len(sys.argv) > 1:
+        df_threads, df_sizes = load_native_results(sys.argv[1], sys.argv[2] if len(sys.argv) > 2 else None)
+    else:
+        df_threads = thread_experiment()
+        df_sizes = size_experiment()
 
     print("\n[Thread 수에 따른 성능 분석 결과]")
     print(df_threads)
@@ -8,4 +8,43 @@ make
 ./vmsim 10 5 LFU < input_example.txt > output_example_lfu.txt
 ./vmsim 10 5 LRU < input_example.txt > output_example_lru.txt
 ./vmsim 10 5 S3FIFO < input_example.txt > output_example_s3fifo.txt
+./vmsim 10 5 CLOCK < input_example.txt > output_example_clock.txt
+./vmsim 10 5 CLOCKPRO < input_example.txt > output_example_clockpro.txt
+./vmsim 10 5 ARC < input_example.txt > output_example_arc.txt
 
+# 바이너리 트레이스를 파이프로 5바이트씩 나눠 보내도 텍스트 입력과 결과가 같아야 한다
+bin=$(mktemp)
+for enc in u32 u64 varint; do
+    ./trace2bin --encoding=$enc < input_example.txt > $bin 2> /dev/null
+    size=$(stat -c %s $bin)
+    for ((off = 0; off < size; off += 5)); do
+        dd if=$bin bs=5 skip=$((off / 5)) count=1 status=none
+        sleep 0.01
+    done | ./vmsim 10 5 FIFO | cmp -s - output_example_fifo.txt || echo "binary trace pipe check failed: $enc"
+done
+rm -f $bin
+
+# 프레임 수가 1 미만이거나 TLB 크기가 음수이면 사용법 오류(rc 1)로 바로 끝나야 한다
+for sizes in "0 4" "-3 4" "64 -2"; do
+    for policy in FIFO LRU LFU S3FIFO CLOCK CLOCKPRO ARC; do
+        timeout 10 ./vmsim $sizes $policy < input_example.txt > /dev/null 2>&1
+        [ $? -eq 1 ] || echo "$policy with sizes $sizes was not rejected"
+    done
+done
+
+# TLB 크기 0이면 모든 정책이 매번 새 엔트리를 바로 내보내고 끝까지 돈다
+for policy in FIFO LRU LFU S3FIFO CLOCK CLOCKPRO ARC; do
+    timeout 10 ./vmsim 10 0 $policy < input_example.txt > /dev/null || echo "$policy with TLB size 0 failed"
+done
+
+# clean-first 교체가 프레임을 잃지 않고 끝까지 도는지 확인 (쓰기가 섞인 / 쓰기뿐인 임의 트레이스)
+trace=$(mktemp)
+for w in 0.3 1; do
+    awk -v w=$w 'BEGIN { srand(1); for (i = 0; i < 20000; i++) printf "0x%08X%s\n", int(rand() * 300) * 4096, rand() < w ? " W" : "" }' > $trace
+    for policy in FIFO LRU LFU S3FIFO; do
+        for opt in --prefer-clean --prefer-clean=4 --prefer-clean=65; do
+            ./vmsim 64 16 $policy $opt --summary-only < $trace > /dev/null || echo "$policy $opt run failed (W ratio $w)"
+        done
+    done
+done
+rm -f $trace
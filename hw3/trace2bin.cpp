@@ -0,0 +1,60 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <unistd.h>
+#include "trace_io.h"
+using namespace std;
+
+// 텍스트 트레이스를 vmsim 바이너리 트레이스로 변환한다.
+// 사용법: ./trace2bin [--encoding=varint|u64|u32] < trace.txt > trace.bin
+// 기본값 varint(델타 + varint)가 가장 작고, PID가 붙은 트레이스는 자동으로 PID를 담는 varint 형식이 된다.
+// u32는 32비트 VA에 접근 유형이 없는 트레이스에만, u64는 PID가 없는 트레이스에만 쓸 수 있다.
+int main(int argc, char* argv[]) {
+    TraceEncoding enc = TRACE_ENC_VARINT;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--encoding=varint") == 0) enc = TRACE_ENC_VARINT;
+        else if (strcmp(argv[i], "--encoding=u64") == 0) enc = TRACE_ENC_U64;
+        else if (strcmp(argv[i], "--encoding=u32") == 0) enc = TRACE_ENC_U32;
+        else {
+            cerr << "Usage: ./trace2bin [--encoding=varint|u64|u32] < trace.txt > trace.bin" << endl;
+            return 1;
+        }
+    }
+
+    TraceReader in(STDIN_FILENO);
+    vector<TraceRecord> recs;
+    TraceRecord rec;
+    while (in.next(rec)) {
+        if (enc == TRACE_ENC_U32 && (rec.va > UINT32_MAX || rec.type != ACCESS_READ)) {
+            cerr << "Error: trace has 64-bit addresses or access types; use --encoding=u64 or varint." << endl;
+            return 1;
+        }
+        if (rec.pid != 0) {
+            if (enc == TRACE_ENC_VARINT) enc = TRACE_ENC_VARINT_PID;
+            else if (enc != TRACE_ENC_VARINT_PID) {
+                cerr << "Error: trace has process IDs; use --encoding=varint." << endl;
+                return 1;
+            }
+        }
+        recs.push_back(rec);
+    }
+    if (in.failed()) {
+        cerr << "Error: malformed binary trace." << endl;
+        return 1;
+    }
+
+    string out;
+    serialize_trace(recs, enc, out);
+    size_t off = 0;
+    while (off < out.size()) {
+        ssize_t n = write(STDOUT_FILENO, out.data() + off, out.size() - off);
+        if (n <= 0) {
+            cerr << "Error: write failed." << endl;
+            return 1;
+        }
+        off += n;
+    }
+    cerr << recs.size() << " references, " << out.size() << " bytes" << endl;
+    return 0;
+}
@@ -0,0 +1,292 @@
+#ifndef TRACE_IO_H
+#define TRACE_IO_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// 메모리 참조 트레이스 입력.
+//
+// 텍스트 형식: 한 줄에 참조 하나. "VA [TYPE] [PID]"
+//   VA는 16진수 (0x 접두사 선택), TYPE은 선택적인 한 글자 I(명령어 인출) / R(읽기) / W(쓰기),
+//   PID는 선택적인 10진수 프로세스 번호 (없으면 0).
+//   빈 줄과 16진수로 시작하지 않는 줄은 건너뛴다.
+//
+// 바이너리 형식 (리틀 엔디언): TraceFileHeader 뒤에 count개의 레코드
+//   TRACE_ENC_U32:    uint32 VA (접근 유형 없음, 모두 R)
+//   TRACE_ENC_U64:    uint64 = VA(하위 62비트) | 유형 << 62
+//   TRACE_ENC_VARINT: LEB128 varint = zigzag(VA - 직전 VA) << 2 | 유형
+//   TRACE_ENC_VARINT_PID: varint = zigzag(VA - 직전 VA) << 3 | PID 바뀜 << 2 | 유형,
+//                         PID가 바뀐 레코드 뒤에는 varint PID가 이어진다
+// 일반 파일은 mmap해서 그대로 읽고, 파이프는 큰 버퍼 단위로 read(2)해서 읽는다.
+const char TRACE_MAGIC[4] = {'V', 'T', 'R', 'C'};
+const uint32_t TRACE_VERSION = 1;
+
+enum TraceEncoding { TRACE_ENC_U32 = 0, TRACE_ENC_U64 = 1, TRACE_ENC_VARINT = 2, TRACE_ENC_VARINT_PID = 3 };
+
+// 접근 유형 (2비트)
+enum AccessType { ACCESS_READ = 0, ACCESS_WRITE = 1, ACCESS_FETCH = 2 };
+
+struct TraceFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t encoding;
+    uint32_t reserved;
+    uint64_t count; // 레코드 수
+};
+
+struct TraceRecord {
+    uint64_t va;
+    uint32_t pid; // 프로세스 번호 (태그 없는 트레이스는 0)
+    uint8_t type; // AccessType
+};
+
+// 트레이스 파일(텍스트/바이너리 자동 판별)을 레코드 단위로 읽는다.
+class TraceReader {
+public:
+    explicit TraceReader(int fd)
+        : fd(fd), buf(nullptr), cap(0), p(nullptr), end(nullptr), mapped(false), eof(false),
+          binary(false), error(false), remaining(0), prev_va(0), prev_pid(0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 && lseek(fd, 0, SEEK_CUR) == 0) {
+            void* m = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m != MAP_FAILED) {
+                madvise(m, st.st_size, MADV_SEQUENTIAL);
+                buf = (char*)m; cap = st.st_size;
+                p = buf; end = buf + cap;
+                mapped = true; eof = true;
+            }
+        }
+        if (!mapped) {
+            cap = 1 << 20;
+            buf = (char*)std::malloc(cap);
+            p = end = buf;
+        }
+        while ((size_t)(end - p) < sizeof(TraceFileHeader) && refill()) {}
+        if ((size_t)(end - p) >= sizeof(TraceFileHeader) && std::memcmp(p, TRACE_MAGIC, 4) == 0) {
+            std::memcpy(&hdr, p, sizeof(hdr));
+            p += sizeof(hdr);
+            binary = true;
+            remaining = hdr.count;
+            error = hdr.version != TRACE_VERSION || hdr.encoding > TRACE_ENC_VARINT_PID;
+        }
+    }
+
+    ~TraceReader() {
+        if (mapped) munmap(buf, cap);
+        else std::free(buf);
+    }
+
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+
+    bool is_binary() const { return binary; }
+    // 바이너리 트레이스가 잘렸거나 형식이 잘못되었으면 true
+    bool failed() const { return error; }
+
+    // 다음 레코드. 끝이거나 오류면 false.
+    bool next(TraceRecord& rec) { return binary ? next_binary(rec) : next_text(rec); }
+
+    // 텍스트 한 줄 [s, e)를 해석한다. 참조가 아닌 줄이면 false.
+    static bool parse_line(const char* s, const char* e, TraceRecord& rec) {
+        while (s < e && (*s == ' ' || *s == '\t' || *s == '\r')) ++s;
+        if (s + 1 < e && s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) s += 2;
+        uint64_t va = 0;
+        const char* digits = s;
+        for (int d; s < e && (d = hex_digit(*s)) >= 0; ++s) va = va << 4 | (uint64_t)d;
+        if (s == digits) return false;
+
+        rec.va = va;
+        rec.pid = 0;
+        rec.type = ACCESS_READ;
+        // 뒤따르는 토큰: 10진수면 PID, 한 글자면 접근 유형, 그 외는 무시
+        for (int t = 0; t < 2; ++t) {
+            while (s < e && (*s == ' ' || *s == '\t')) ++s;
+            const char* tok = s;
+            uint64_t num = 0;
+            bool numeric = true;
+            for (; s < e && *s != ' ' && *s != '\t' && *s != '\r'; ++s) {
+                if (*s >= '0' && *s <= '9') num = num * 10 + (uint64_t)(*s - '0');
+                else numeric = false;
+            }
+            if (s == tok) break;
+            if (numeric) rec.pid = (uint32_t)num;
+            else if (s - tok == 1 && (*tok == 'I' || *tok == 'i')) rec.type = ACCESS_FETCH;
+            else if (s - tok == 1 && (*tok == 'W' || *tok == 'w')) rec.type = ACCESS_WRITE;
+        }
+        return true;
+    }
+
+private:
+    int fd;
+    char* buf;
+    size_t cap;
+    const char* p;   // 다음에 읽을 위치
+    const char* end; // 버퍼에 채워진 끝
+    bool mapped, eof;
+    bool binary, error;
+    TraceFileHeader hdr;
+    uint64_t remaining; // 남은 바이너리 레코드 수
+    uint64_t prev_va;   // varint 델타 기준
+    uint32_t prev_pid;  // TRACE_ENC_VARINT_PID에서 직전 레코드의 PID
+
+    static int hex_digit(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    // 남은 바이트를 버퍼 앞으로 옮기고 더 읽는다. 새로 읽은 것이 없으면 false.
+    bool refill() {
+        if (eof) return false;
+        size_t left = end - p;
+        if (left == cap) {
+            cap *= 2;
+            char* bigger = (char*)std::malloc(cap);
+            std::memcpy(bigger, p, left);
+            std::free(buf);
+            buf = bigger;
+        } else {
+            std::memmove(buf, p, left);
+        }
+        p = buf;
+        end = buf + left;
+        ssize_t n = read(fd, buf + left, cap - left);
+        if (n <= 0) {
+            eof = true;
+            return false;
+        }
+        end += n;
+        return true;
+    }
+
+    bool next_text(TraceRecord& rec) {
+        for (;;) {
+            const char* nl = (const char*)std::memchr(p, '\n', end - p);
+            if (!nl) {
+                if (refill()) continue;
+                if (p == end) return false;
+                nl = end; // 마지막 줄에 개행이 없는 경우
+            }
+            const char* line = p;
+            p = nl < end ? nl + 1 : end;
+            if (parse_line(line, nl, rec)) return true;
+        }
+    }
+
+    bool next_binary(TraceRecord& rec) {
+        if (error || remaining == 0) return false;
+        // 레코드 하나(최대 varint 두 개)가 다 들어오거나 EOF가 될 때까지 채운다.
+        // 파이프는 read(2) 한 번에 레코드 일부만 줄 수 있다.
+        while (end - p < 32 && refill()) {}
+        size_t avail = end - p;
+        const unsigned char* q = (const unsigned char*)p;
+
+        rec.pid = 0;
+        if (hdr.encoding == TRACE_ENC_U32) {
+            if (avail < 4) return fail();
+            uint32_t v;
+            std::memcpy(&v, q, 4);
+            rec.va = v;
+            rec.type = ACCESS_READ;
+            p += 4;
+        } else if (hdr.encoding == TRACE_ENC_U64) {
+            if (avail < 8) return fail();
+            uint64_t v;
+            std::memcpy(&v, q, 8);
+            rec.va = v & ((1ull << 62) - 1);
+            rec.type = (uint8_t)(v >> 62);
+            p += 8;
+        } else {
+            uint64_t v;
+            size_t used = read_varint(q, avail, v);
+            if (!used) return fail();
+            uint64_t zz = v >> 2;
+            if (hdr.encoding == TRACE_ENC_VARINT_PID) {
+                zz = v >> 3;
+                if (v & 4) {
+                    uint64_t pid;
+                    size_t n = read_varint(q + used, avail - used, pid);
+                    if (!n || pid > UINT32_MAX) return fail();
+                    prev_pid = (uint32_t)pid;
+                    used += n;
+                }
+                rec.pid = prev_pid;
+            }
+            p += used;
+            int64_t delta = (int64_t)(zz >> 1) ^ -(int64_t)(zz & 1);
+            prev_va += (uint64_t)delta;
+            rec.va = prev_va;
+            rec.type = (uint8_t)(v & 3);
+        }
+        --remaining;
+        return true;
+    }
+
+    // LEB128 varint 하나. 읽은 바이트 수, 잘렸거나 너무 길면 0.
+    static size_t read_varint(const unsigned char* q, size_t avail, uint64_t& v) {
+        v = 0;
+        for (size_t i = 0, shift = 0; i < avail && shift <= 63; ++i, shift += 7) {
+            v |= (uint64_t)(q[i] & 0x7F) << shift;
+            if (!(q[i] & 0x80)) return i + 1;
+        }
+        return 0;
+    }
+
+    bool fail() {
+        error = true;
+        return false;
+    }
+};
+
+inline void append_varint(uint64_t v, std::string& out) {
+    do {
+        unsigned char byte = v & 0x7F;
+        v >>= 7;
+        if (v) byte |= 0x80;
+        out.push_back((char)byte);
+    } while (v);
+}
+
+// 레코드들을 바이너리 트레이스 형식으로 직렬화한다. PID는 TRACE_ENC_VARINT_PID만 담는다.
+inline void serialize_trace(const std::vector<TraceRecord>& recs, TraceEncoding enc, std::string& out) {
+    TraceFileHeader hdr;
+    std::memset(&hdr, 0, sizeof(hdr));
+    std::memcpy(hdr.magic, TRACE_MAGIC, 4);
+    hdr.version = TRACE_VERSION;
+    hdr.encoding = enc;
+    hdr.count = recs.size();
+
+    out.assign((const char*)&hdr, sizeof(hdr));
+    uint64_t prev = 0;
+    uint32_t prev_pid = 0;
+    for (const TraceRecord& r : recs) {
+        if (enc == TRACE_ENC_U32) {
+            uint32_t v = (uint32_t)r.va;
+            out.append((const char*)&v, 4);
+        } else if (enc == TRACE_ENC_U64) {
+            uint64_t v = (r.va & ((1ull << 62) - 1)) | (uint64_t)r.type << 62;
+            out.append((const char*)&v, 8);
+        } else {
+            int64_t delta = (int64_t)(r.va - prev);
+            uint64_t zz = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+            prev = r.va;
+            if (enc == TRACE_ENC_VARINT) {
+                append_varint(zz << 2 | r.type, out);
+            } else {
+                bool switched = r.pid != prev_pid;
+                append_varint(zz << 3 | (uint64_t)switched << 2 | r.type, out);
+                if (switched) append_varint(r.pid, out);
+                prev_pid = r.pid;
+            }
+        }
+    }
+}
+
+#endif